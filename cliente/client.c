@@ -9,18 +9,51 @@
 #include <getopt.h>
 #include <stdarg.h>
 #include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include <libgen.h>
 #include "protocol_defs.h"
+#include "timer_wheel.h"
 
 #define SERVER_IP "127.0.0.1"
 #define SERVER_PORT 12345
 #define TIMEOUT_SEC 1
+#define RETRANSMIT_TIMEOUT_MS (TIMEOUT_SEC * 1000)
 #define MAX_RETRIES 10
 
 // Variáveis globais para configuração
 bool verbose_mode = false;
 double loss_probability = 0.0;
 
+// Fases da transferência
+typedef enum {
+    PHASE_START,
+    PHASE_DATA,
+    PHASE_EOT,
+    PHASE_DONE,
+    PHASE_FAILED
+} TransferPhase;
+
+// Estado da transferência; o pacote em trânsito é retransmitido pelo timer
+typedef struct {
+    int sockfd;
+    struct sockaddr_in server_addr;
+    FILE *input_file;
+    const char *filename;
+
+    TransferPhase phase;
+    StartPacket start_pkt;
+    Packet data_pkt;
+    uint8_t sequence_to_send;
+    int retries;
+
+    TimerWheel wheel;
+    Timer retransmit_timer;
+
+    long long total_packets_sent;
+    long long total_retransmissions;
+} Transfer;
+
 void print_usage(const char *prog_name) {
     fprintf(stderr, "Uso: %s <caminho_do_arquivo> [-v] [-l prob]\n", prog_name);
     fprintf(stderr, "  -v, --verbose          Ativa o modo de log detalhado.\n");
@@ -37,6 +70,196 @@ void verbose_log(const char *format, ...) {
     }
 }
 
+// Envia (ou reenvia) o pacote da fase atual e arma o timer de retransmissão
+void send_current(Transfer *tr) {
+    const void *pkt;
+    size_t len;
+
+    switch (tr->phase) {
+        case PHASE_START:
+            verbose_log("[CLIENT] Enviando pacote START para o arquivo '%s'. Tentativa: %d\n", tr->filename, tr->retries + 1);
+            pkt = &tr->start_pkt;
+            len = sizeof(PacketHeader) + tr->start_pkt.header.length;
+            break;
+        case PHASE_DATA:
+            verbose_log("[CLIENT] Enviando pacote de DADOS (seq: %d, len: %u). Tentativa: %d\n",
+                   tr->data_pkt.header.sequence_num, tr->data_pkt.header.length, tr->retries + 1);
+            pkt = &tr->data_pkt;
+            len = sizeof(PacketHeader) + tr->data_pkt.header.length;
+            break;
+        case PHASE_EOT:
+            verbose_log("[CLIENT] Enviando pacote EOT (seq: %d). Tentativa: %d\n", tr->data_pkt.header.sequence_num, tr->retries + 1);
+            pkt = &tr->data_pkt.header;
+            len = sizeof(PacketHeader);
+            break;
+        default:
+            return;
+    }
+
+    if (!simulate_loss(loss_probability)) {
+        sendto(tr->sockfd, pkt, len, 0, (const struct sockaddr *)&tr->server_addr, sizeof(tr->server_addr));
+    } else if (tr->phase == PHASE_START) {
+        verbose_log("[CLIENT] >> Simulação de perda do pacote START.\n");
+    } else if (tr->phase == PHASE_DATA) {
+        verbose_log("[CLIENT] >> Simulação de perda do pacote de DADOS (seq: %d).\n", tr->data_pkt.header.sequence_num);
+    } else {
+        verbose_log("[CLIENT] >> Simulação de perda do pacote EOT.\n");
+    }
+    tr->total_packets_sent++;
+
+    timer_wheel_schedule(&tr->wheel, &tr->retransmit_timer, timer_wheel_now_ms() + RETRANSMIT_TIMEOUT_MS);
+}
+
+// Encerra a fase atual após esgotar as retransmissões
+void fail_current(Transfer *tr) {
+    timer_cancel(&tr->wheel, &tr->retransmit_timer);
+
+    switch (tr->phase) {
+        case PHASE_START:
+            fprintf(stderr, "ERRO: Servidor não respondeu ao início da transmissão. Abortando.\n");
+            tr->phase = PHASE_FAILED;
+            break;
+        case PHASE_DATA:
+            fprintf(stderr, "ERRO: Máximo de retransmissões excedido para pacote (seq: %d). Abortando.\n",
+                    tr->data_pkt.header.sequence_num);
+            tr->phase = PHASE_DONE;
+            break;
+        case PHASE_EOT:
+            fprintf(stderr, "AVISO: Falha ao confirmar EOT após retransmissões.\n");
+            tr->phase = PHASE_DONE;
+            break;
+        default:
+            break;
+    }
+}
+
+void retransmit_current(Transfer *tr) {
+    tr->total_retransmissions++;
+    tr->retries++;
+    if (tr->retries >= MAX_RETRIES) {
+        fail_current(tr);
+        return;
+    }
+    send_current(tr);
+}
+
+void on_retransmit_timeout(Timer *timer, void *arg) {
+    Transfer *tr = arg;
+    (void)timer;
+
+    if (tr->phase == PHASE_START) {
+        verbose_log("[CLIENT] TIMEOUT! Nenhum ACK recebido para o pacote START.\n");
+    } else if (tr->phase == PHASE_DATA) {
+        verbose_log("[CLIENT] TIMEOUT! Nenhum ACK para pacote (seq: %d).\n", tr->data_pkt.header.sequence_num);
+    } else {
+        verbose_log("[CLIENT] TIMEOUT! Nenhum ACK para EOT (seq: %d).\n", tr->data_pkt.header.sequence_num);
+    }
+    retransmit_current(tr);
+}
+
+// 3. Enviar pacote de FIM DE TRANSMISSÃO (EOT)
+void begin_eot(Transfer *tr) {
+    tr->phase = PHASE_EOT;
+    tr->data_pkt.header.type = PKT_EOT;
+    tr->data_pkt.header.sequence_num = tr->sequence_to_send;
+    tr->data_pkt.header.length = 0;
+    tr->data_pkt.header.checksum = 0;
+    tr->retries = 0;
+    send_current(tr);
+}
+
+// 2. Enviar o próximo bloco de dados do arquivo (ou EOT no fim do arquivo)
+void begin_next_data(Transfer *tr) {
+    size_t bytes_read = fread(tr->data_pkt.payload, 1, MAX_PAYLOAD_SIZE, tr->input_file);
+
+    if (bytes_read == 0) {
+        if (!feof(tr->input_file)) {
+            perror("Error reading file");
+        }
+        begin_eot(tr);
+        return;
+    }
+
+    tr->phase = PHASE_DATA;
+    tr->data_pkt.header.type = PKT_DATA;
+    tr->data_pkt.header.sequence_num = tr->sequence_to_send;
+    tr->data_pkt.header.length = bytes_read;
+    tr->data_pkt.header.checksum = calculate_checksum(tr->data_pkt.payload, tr->data_pkt.header.length);
+    tr->retries = 0;
+    send_current(tr);
+}
+
+void handle_ack(Transfer *tr, const char *ack_recv_buffer, ssize_t n_ack) {
+    ACKPacket ack_pkt;
+    memset(&ack_pkt, 0, sizeof(ack_pkt));
+    memcpy(&ack_pkt, ack_recv_buffer, n_ack);
+
+    if (tr->phase == PHASE_START) {
+        if (ack_pkt.type == PKT_ACK) { // ACK para START não tem sequence_num
+            verbose_log("[CLIENT] ACK para START recebido.\n");
+            timer_cancel(&tr->wheel, &tr->retransmit_timer);
+            begin_next_data(tr);
+        }
+        return;
+    }
+
+    if (tr->phase != PHASE_DATA && tr->phase != PHASE_EOT) {
+        return;
+    }
+
+    uint8_t expected = tr->data_pkt.header.sequence_num;
+
+    if (simulate_loss(loss_probability)) {
+        if (tr->phase == PHASE_DATA) {
+            verbose_log("[CLIENT] >> Simulação de perda do ACK recebido para (seq: %d).\n", expected);
+        } else {
+            verbose_log("[CLIENT] >> Simulação de perda do ACK para EOT.\n");
+        }
+        retransmit_current(tr);
+        return;
+    }
+
+    if (ack_pkt.type == PKT_ACK && ack_pkt.sequence_num == expected) {
+        timer_cancel(&tr->wheel, &tr->retransmit_timer);
+        if (tr->phase == PHASE_DATA) {
+            verbose_log("[CLIENT] ACK recebido para pacote (seq: %d).\n", ack_pkt.sequence_num);
+            tr->sequence_to_send = 1 - tr->sequence_to_send;
+            begin_next_data(tr);
+        } else {
+            verbose_log("[CLIENT] ACK de EOT recebido (seq: %d).\n", ack_pkt.sequence_num);
+            tr->phase = PHASE_DONE;
+        }
+    } else {
+        if (tr->phase == PHASE_DATA) {
+            verbose_log("[CLIENT] ACK inesperado (seq: %d, tipo: %d). Esperava seq: %d. Retransmitindo.\n",
+                   ack_pkt.sequence_num, ack_pkt.type, expected);
+        } else {
+            verbose_log("[CLIENT] ACK inesperado para EOT (seq: %d). Retransmitindo.\n", ack_pkt.sequence_num);
+        }
+        retransmit_current(tr);
+    }
+}
+
+// Lê todos os ACKs disponíveis no socket sem bloquear
+void receive_acks(Transfer *tr) {
+    while (tr->phase != PHASE_DONE && tr->phase != PHASE_FAILED) {
+        char ack_recv_buffer[sizeof(ACKPacket)];
+        ssize_t n_ack = recvfrom(tr->sockfd, ack_recv_buffer, sizeof(ACKPacket), MSG_DONTWAIT, NULL, NULL);
+
+        if (n_ack < 0) {
+            if (errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR) {
+                return;
+            }
+            perror("recvfrom ACK failed");
+            fail_current(tr);
+            return;
+        }
+        if (n_ack > 0) {
+            handle_ack(tr, ack_recv_buffer, n_ack);
+        }
+    }
+}
+
 int main(int argc, char *argv[]) {
     char *filepath = NULL;
 
@@ -73,236 +296,128 @@ int main(int argc, char *argv[]) {
     }
     filepath = argv[optind];
 
-    int sockfd;
-    struct sockaddr_in server_addr;
-    FILE *input_file;
-
-    long long total_packets_sent = 0;
-    long long total_retransmissions = 0;
+    Transfer tr;
+    memset(&tr, 0, sizeof(tr));
+    int timer_fd, epoll_fd;
     time_t start_time, end_time;
 
     init_random();
 
-    if ((sockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+    if ((tr.sockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
         perror("socket creation failed");
         exit(EXIT_FAILURE);
     }
 
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(SERVER_PORT);
-    if (inet_pton(AF_INET, SERVER_IP, &server_addr.sin_addr) <= 0) {
+    tr.server_addr.sin_family = AF_INET;
+    tr.server_addr.sin_port = htons(SERVER_PORT);
+    if (inet_pton(AF_INET, SERVER_IP, &tr.server_addr.sin_addr) <= 0) {
         perror("Invalid address/ Address not supported");
-        close(sockfd);
+        close(tr.sockfd);
+        exit(EXIT_FAILURE);
+    }
+
+    // Os timeouts vêm da roda de timers (timerfd), não de SO_RCVTIMEO
+    if ((timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+        perror("timerfd_create failed");
+        close(tr.sockfd);
         exit(EXIT_FAILURE);
     }
 
-    struct timeval tv;
-    tv.tv_sec = TIMEOUT_SEC;
-    tv.tv_usec = 0;
-    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof tv) < 0) {
-        perror("setsockopt failed");
-        close(sockfd);
+    if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        perror("epoll_create1 failed");
+        close(timer_fd);
+        close(tr.sockfd);
         exit(EXIT_FAILURE);
     }
 
-    input_file = fopen(filepath, "rb");
-    if (!input_file) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = tr.sockfd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, tr.sockfd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        close(epoll_fd);
+        close(timer_fd);
+        close(tr.sockfd);
+        exit(EXIT_FAILURE);
+    }
+    ev.data.fd = timer_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        close(epoll_fd);
+        close(timer_fd);
+        close(tr.sockfd);
+        exit(EXIT_FAILURE);
+    }
+
+    tr.input_file = fopen(filepath, "rb");
+    if (!tr.input_file) {
         perror("Error opening input file");
-        close(sockfd);
+        close(epoll_fd);
+        close(timer_fd);
+        close(tr.sockfd);
         exit(EXIT_FAILURE);
     }
-    
+
     char* filename = basename(filepath);
+    tr.filename = filename;
 
     printf("Iniciando transferência do arquivo '%s' para %s:%d...\n", filename, SERVER_IP, SERVER_PORT);
     if(verbose_mode) printf("Modo Verbose Ativado. Probabilidade de Perda: %.2f%%\n", loss_probability * 100);
 
     time(&start_time);
 
-    // 1. Enviar pacote de START de forma confiável
-    StartPacket start_pkt;
-    start_pkt.header.type = PKT_START;
-    start_pkt.header.length = strlen(filename);
-    strncpy(start_pkt.filename, filename, MAX_FILENAME_SIZE);
-    start_pkt.filename[MAX_FILENAME_SIZE] = '\0';
-    start_pkt.header.checksum = calculate_checksum(start_pkt.filename, start_pkt.header.length);
-
-    int retries = 0;
-    bool start_acked = false;
-    do {
-        verbose_log("[CLIENT] Enviando pacote START para o arquivo '%s'. Tentativa: %d\n", filename, retries + 1);
-        
-        if (!simulate_loss(loss_probability)) {
-            sendto(sockfd, &start_pkt, sizeof(PacketHeader) + start_pkt.header.length, 0,
-                   (const struct sockaddr *)&server_addr, sizeof(server_addr));
-        } else {
-             verbose_log("[CLIENT] >> Simulação de perda do pacote START.\n");
-        }
-        total_packets_sent++;
-
-        char ack_recv_buffer[sizeof(ACKPacket)];
-        ssize_t n_ack = recvfrom(sockfd, ack_recv_buffer, sizeof(ACKPacket), 0, NULL, NULL);
+    timer_wheel_init(&tr.wheel, timer_wheel_now_ms());
+    timer_init(&tr.retransmit_timer, on_retransmit_timeout, &tr);
 
-        if (n_ack > 0) {
-            ACKPacket ack_pkt;
-            memcpy(&ack_pkt, ack_recv_buffer, n_ack);
-            if (ack_pkt.type == PKT_ACK) { // ACK para START não tem sequence_num
-                verbose_log("[CLIENT] ACK para START recebido.\n");
-                start_acked = true;
-            }
-        } else {
-            verbose_log("[CLIENT] TIMEOUT! Nenhum ACK recebido para o pacote START.\n");
-            total_retransmissions++;
-            retries++;
+    // 1. Enviar pacote de START de forma confiável
+    tr.phase = PHASE_START;
+    tr.start_pkt.header.type = PKT_START;
+    tr.start_pkt.header.length = strlen(filename);
+    strncpy(tr.start_pkt.filename, filename, MAX_FILENAME_SIZE);
+    tr.start_pkt.filename[MAX_FILENAME_SIZE] = '\0';
+    tr.start_pkt.header.checksum = calculate_checksum(tr.start_pkt.filename, tr.start_pkt.header.length);
+    tr.sequence_to_send = 0;
+    tr.retries = 0;
+    send_current(&tr);
+
+    // Laço de eventos: ACKs do socket e prazos da roda de timers via timerfd
+    while (tr.phase != PHASE_DONE && tr.phase != PHASE_FAILED) {
+        if (timer_wheel_arm_timerfd(&tr.wheel, timer_fd) < 0) {
+            perror("timerfd_settime failed");
+            break;
         }
-    } while (!start_acked && retries < MAX_RETRIES);
 
-    if (!start_acked) {
-        fprintf(stderr, "ERRO: Servidor não respondeu ao início da transmissão. Abortando.\n");
-        fclose(input_file);
-        close(sockfd);
-        return EXIT_FAILURE;
-    }
-
-
-    // 2. Enviar dados do arquivo
-    Packet data_pkt;
-    ACKPacket ack_pkt;
-    ssize_t bytes_read;
-    uint8_t sequence_to_send = 0;
-
-    while (true) {
-        bytes_read = fread(data_pkt.payload, 1, MAX_PAYLOAD_SIZE, input_file);
-        
-        if (bytes_read == 0 && feof(input_file)) {
-            break; // Fim do arquivo
-        }
-        if (bytes_read == 0 && !feof(input_file)) {
-            perror("Error reading file");
+        struct epoll_event events[2];
+        int nfds = epoll_wait(epoll_fd, events, 2, -1);
+        if (nfds < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
             break;
         }
 
-        data_pkt.header.type = PKT_DATA;
-        data_pkt.header.sequence_num = sequence_to_send;
-        data_pkt.header.length = bytes_read;
-        data_pkt.header.checksum = calculate_checksum(data_pkt.payload, data_pkt.header.length);
-
-        retries = 0;
-        bool ack_received = false;
-        do {
-            verbose_log("[CLIENT] Enviando pacote de DADOS (seq: %d, len: %u). Tentativa: %d\n",
-                   data_pkt.header.sequence_num, data_pkt.header.length, retries + 1);
-
-            if (!simulate_loss(loss_probability)) {
-                sendto(sockfd, &data_pkt, sizeof(PacketHeader) + data_pkt.header.length, 0,
-                       (const struct sockaddr *)&server_addr, sizeof(server_addr));
-            } else {
-                verbose_log("[CLIENT] >> Simulação de perda do pacote de DADOS (seq: %d).\n", data_pkt.header.sequence_num);
-            }
-            total_packets_sent++;
-
-            char ack_recv_buffer[sizeof(ACKPacket)];
-            ssize_t n_ack = recvfrom(sockfd, ack_recv_buffer, sizeof(ACKPacket), 0, NULL, NULL);
-
-            if (n_ack < 0) {
-                if (errno == EWOULDBLOCK || errno == EAGAIN) {
-                    verbose_log("[CLIENT] TIMEOUT! Nenhum ACK para pacote (seq: %d).\n", data_pkt.header.sequence_num);
-                    total_retransmissions++;
-                    retries++;
-                } else {
-                    perror("recvfrom ACK failed");
-                    break;
+        for (int i = 0; i < nfds; i++) {
+            if (events[i].data.fd == timer_fd) {
+                uint64_t expirations;
+                if (read(timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+                    perror("read timerfd failed");
                 }
             } else {
-                if (simulate_loss(loss_probability)) {
-                    verbose_log("[CLIENT] >> Simulação de perda do ACK recebido para (seq: %d).\n", sequence_to_send);
-                    total_retransmissions++;
-                    retries++;
-                    continue;
-                }
-                
-                memcpy(&ack_pkt, ack_recv_buffer, n_ack);
-
-                if (ack_pkt.type == PKT_ACK && ack_pkt.sequence_num == sequence_to_send) {
-                    verbose_log("[CLIENT] ACK recebido para pacote (seq: %d).\n", ack_pkt.sequence_num);
-                    ack_received = true;
-                } else {
-                    verbose_log("[CLIENT] ACK inesperado (seq: %d, tipo: %d). Esperava seq: %d. Retransmitindo.\n",
-                           ack_pkt.sequence_num, ack_pkt.type, sequence_to_send);
-                    total_retransmissions++;
-                    retries++;
-                }
+                receive_acks(&tr);
             }
-        } while (!ack_received && retries < MAX_RETRIES);
-
-        if (!ack_received) {
-            fprintf(stderr, "ERRO: Máximo de retransmissões excedido para pacote (seq: %d). Abortando.\n",
-                    data_pkt.header.sequence_num);
-            goto cleanup;
         }
 
-        sequence_to_send = 1 - sequence_to_send;
+        timer_wheel_advance(&tr.wheel, timer_wheel_now_ms());
     }
 
-    // 3. Enviar pacote de FIM DE TRANSMISSÃO (EOT)
-    data_pkt.header.type = PKT_EOT;
-    data_pkt.header.sequence_num = sequence_to_send;
-    data_pkt.header.length = 0;
-    data_pkt.header.checksum = 0;
-
-    retries = 0;
-    bool eot_acked = false;
-    do {
-        verbose_log("[CLIENT] Enviando pacote EOT (seq: %d). Tentativa: %d\n", data_pkt.header.sequence_num, retries + 1);
-        if (!simulate_loss(loss_probability)) {
-            sendto(sockfd, &data_pkt.header, sizeof(PacketHeader), 0,
-                   (const struct sockaddr *)&server_addr, sizeof(server_addr));
-        } else {
-            verbose_log("[CLIENT] >> Simulação de perda do pacote EOT.\n");
-        }
-        total_packets_sent++;
-
-        char ack_recv_buffer[sizeof(ACKPacket)];
-        ssize_t n_ack = recvfrom(sockfd, ack_recv_buffer, sizeof(ACKPacket), 0, NULL, NULL);
-
-        if (n_ack < 0) {
-            if (errno == EWOULDBLOCK || errno == EAGAIN) {
-                verbose_log("[CLIENT] TIMEOUT! Nenhum ACK para EOT (seq: %d).\n", data_pkt.header.sequence_num);
-                total_retransmissions++;
-                retries++;
-            } else {
-                perror("recvfrom ACK for EOT failed");
-                break;
-            }
-        } else {
-             if (simulate_loss(loss_probability)) {
-                verbose_log("[CLIENT] >> Simulação de perda do ACK para EOT.\n");
-                total_retransmissions++;
-                retries++;
-                continue;
-            }
-            
-            memcpy(&ack_pkt, ack_recv_buffer, n_ack);
-            if (ack_pkt.type == PKT_ACK && ack_pkt.sequence_num == data_pkt.header.sequence_num) {
-                verbose_log("[CLIENT] ACK de EOT recebido (seq: %d).\n", ack_pkt.sequence_num);
-                eot_acked = true;
-            } else {
-                 verbose_log("[CLIENT] ACK inesperado para EOT (seq: %d). Retransmitindo.\n", ack_pkt.sequence_num);
-                 total_retransmissions++;
-                 retries++;
-            }
-        }
-    } while (!eot_acked && retries < MAX_RETRIES);
+    fclose(tr.input_file);
+    close(epoll_fd);
+    close(timer_fd);
+    close(tr.sockfd);
 
-    if (!eot_acked) {
-        fprintf(stderr, "AVISO: Falha ao confirmar EOT após retransmissões.\n");
+    if (tr.phase == PHASE_FAILED) {
+        return EXIT_FAILURE;
     }
 
-cleanup:
-    fclose(input_file);
-    close(sockfd);
-
     time(&end_time);
     double total_time = difftime(end_time, start_time);
     if (total_time < 1) total_time = 1; // Evitar divisão por zero
@@ -310,12 +425,12 @@ cleanup:
     printf("\n--- Estatísticas do Cliente ---\n");
     printf("Transferência concluída.\n");
     printf("Tempo total de transferência: %.2f segundos\n", total_time);
-    printf("Total de pacotes (START/DATA/EOT) enviados: %lld\n", total_packets_sent);
-    printf("Total de retransmissões: %lld\n", total_retransmissions);
-    if (total_packets_sent > 1) {
-       printf("Taxa de retransmissão: %.2f%%\n", (double)total_retransmissions / (total_packets_sent) * 100);
+    printf("Total de pacotes (START/DATA/EOT) enviados: %lld\n", tr.total_packets_sent);
+    printf("Total de retransmissões: %lld\n", tr.total_retransmissions);
+    if (tr.total_packets_sent > 1) {
+       printf("Taxa de retransmissão: %.2f%%\n", (double)tr.total_retransmissions / (tr.total_packets_sent) * 100);
     }
     printf("----------------------------------\n");
 
     return 0;
-}
\ No newline at end of file
+}
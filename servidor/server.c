@@ -5,17 +5,42 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <errno.h>
 #include <getopt.h>
 #include <stdarg.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include "protocol_defs.h"
+#include "timer_wheel.h"
 
 #define SERVER_PORT 12345
 #define BUFFER_SIZE (sizeof(Packet))
+#define MAX_SESSIONS 64
+#define ACK_DELAY_MS 0             // ACKs de dados saem ao fim do lote de leituras, agrupando duplicatas
+#define SESSION_IDLE_TIMEOUT_MS 30000
+
+// Estado de recepção de um cliente, identificado pelo endereço de origem
+typedef struct {
+    bool in_use;
+    struct sockaddr_in addr;
+    FILE *output_file;
+    uint8_t expected_sequence;
+    ACKPacket pending_ack; // ACK atrasado aguardando o ack_timer
+    Timer ack_timer;
+    Timer idle_timer;
+} Session;
 
 // Variáveis globais para configuração
 bool verbose_mode = false;
 double loss_probability = 0.0;
 
+// Estado compartilhado pelo laço de eventos e pelos callbacks dos timers
+int sockfd;
+TimerWheel wheel;
+Session sessions[MAX_SESSIONS];
+int active_sessions = 0;
+long long expired_sessions = 0;
+
 void print_usage(const char *prog_name) {
     fprintf(stderr, "Uso: %s [-v] [-l prob]\n", prog_name);
     fprintf(stderr, "  -v, --verbose          Ativa o modo de log detalhado.\n");
@@ -32,6 +57,69 @@ void verbose_log(const char *format, ...) {
     }
 }
 
+Session *find_session(const struct sockaddr_in *addr) {
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        if (sessions[i].in_use &&
+            sessions[i].addr.sin_addr.s_addr == addr->sin_addr.s_addr &&
+            sessions[i].addr.sin_port == addr->sin_port) {
+            return &sessions[i];
+        }
+    }
+    return NULL;
+}
+
+void close_session(Session *session) {
+    timer_cancel(&wheel, &session->ack_timer);
+    timer_cancel(&wheel, &session->idle_timer);
+    if (session->output_file) fclose(session->output_file);
+    session->output_file = NULL;
+    session->in_use = false;
+    active_sessions--;
+}
+
+void on_ack_timer(Timer *timer, void *arg) {
+    Session *session = arg;
+    (void)timer;
+
+    if (!simulate_loss(loss_probability)) {
+        sendto(sockfd, &session->pending_ack, sizeof(ACKPacket), 0,
+               (const struct sockaddr *)&session->addr, sizeof(session->addr));
+        verbose_log("[SERVER] Enviado ACK para pacote (seq: %d).\n", session->pending_ack.sequence_num);
+    } else {
+        verbose_log("[SERVER] >> Simulação de perda do ACK (para seq: %d).\n", session->pending_ack.sequence_num);
+    }
+}
+
+void on_idle_timer(Timer *timer, void *arg) {
+    Session *session = arg;
+    (void)timer;
+
+    printf("Sessão de %s:%d expirada por inatividade.\n",
+           inet_ntoa(session->addr.sin_addr), ntohs(session->addr.sin_port));
+    expired_sessions++;
+    close_session(session);
+}
+
+Session *open_session(const struct sockaddr_in *addr) {
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        if (!sessions[i].in_use) {
+            Session *session = &sessions[i];
+            memset(session, 0, sizeof(*session));
+            session->in_use = true;
+            session->addr = *addr;
+            timer_init(&session->ack_timer, on_ack_timer, session);
+            timer_init(&session->idle_timer, on_idle_timer, session);
+            active_sessions++;
+            return session;
+        }
+    }
+    return NULL;
+}
+
+void touch_session(Session *session) {
+    timer_wheel_schedule(&wheel, &session->idle_timer, timer_wheel_now_ms() + SESSION_IDLE_TIMEOUT_MS);
+}
+
 int main(int argc, char *argv[]) {
     // Parsing de argumentos da linha de comando
     const struct option long_options[] = {
@@ -59,15 +147,15 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    int sockfd;
     struct sockaddr_in server_addr, client_addr;
-    socklen_t addr_len = sizeof(client_addr);
+    socklen_t addr_len;
     char buffer[BUFFER_SIZE];
-    FILE *output_file = NULL;
+    int timer_fd, epoll_fd;
 
     long long total_packets_received = 0;
     long long duplicate_packets = 0;
     long long corrupted_packets = 0;
+    long long completed_transfers = 0;
 
     init_random();
 
@@ -89,122 +177,195 @@ int main(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
     }
 
-    printf("Servidor UDP ouvindo na porta %d...\n", SERVER_PORT);
-    if(verbose_mode) printf("Modo Verbose Ativado. Probabilidade de Perda: %.2f%%\n", loss_probability * 100);
+    // ACKs atrasados e expiração de sessões vêm da roda de timers (timerfd)
+    if ((timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+        perror("timerfd_create failed");
+        close(sockfd);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        perror("epoll_create1 failed");
+        close(timer_fd);
+        close(sockfd);
+        exit(EXIT_FAILURE);
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = sockfd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sockfd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        close(epoll_fd);
+        close(timer_fd);
+        close(sockfd);
+        exit(EXIT_FAILURE);
+    }
+    ev.data.fd = timer_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        close(epoll_fd);
+        close(timer_fd);
+        close(sockfd);
+        exit(EXIT_FAILURE);
+    }
 
-    bool receiving_data = false;
-    uint8_t expected_sequence = 0;
+    timer_wheel_init(&wheel, timer_wheel_now_ms());
 
-    while (true) {
-        ssize_t n = recvfrom(sockfd, buffer, BUFFER_SIZE, 0,
-                             (struct sockaddr *)&client_addr, &addr_len);
+    printf("Servidor UDP ouvindo na porta %d...\n", SERVER_PORT);
+    if(verbose_mode) printf("Modo Verbose Ativado. Probabilidade de Perda: %.2f%%\n", loss_probability * 100);
 
-        if (n < 0) {
-            perror("recvfrom failed");
-            continue;
-        }
-        
-        if (simulate_loss(loss_probability)) {
-            verbose_log("[SERVER] >> Simulação de perda de pacote recebido.\n");
-            continue;
+    // Encerra quando ao menos uma transferência terminou e não há sessões ativas
+    while (completed_transfers == 0 || active_sessions > 0) {
+        if (timer_wheel_arm_timerfd(&wheel, timer_fd) < 0) {
+            perror("timerfd_settime failed");
+            break;
         }
 
-        PacketHeader *header = (PacketHeader *)buffer;
-        
-        // Tratar pacotes START
-        if (header->type == PKT_START) {
-            StartPacket *start_pkt = (StartPacket *)buffer;
-            uint16_t calculated_chksum = calculate_checksum(start_pkt->filename, start_pkt->header.length);
+        struct epoll_event events[2];
+        int nfds = epoll_wait(epoll_fd, events, 2, -1);
+        if (nfds < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            break;
+        }
 
-            if (calculated_chksum != start_pkt->header.checksum) {
-                verbose_log("[SERVER] Pacote START corrompido. Descartando.\n");
-                corrupted_packets++;
+        for (int i = 0; i < nfds; i++) {
+            if (events[i].data.fd == timer_fd) {
+                uint64_t expirations;
+                if (read(timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+                    perror("read timerfd failed");
+                }
                 continue;
             }
 
-            char filename[MAX_FILENAME_SIZE + 1];
-            strncpy(filename, start_pkt->filename, start_pkt->header.length);
-            filename[start_pkt->header.length] = '\0';
-            
-            printf("Recebendo arquivo: %s\n", filename);
-
-            output_file = fopen(filename, "wb");
-            if (!output_file) {
-                perror("Error opening output file");
-                close(sockfd);
-                exit(EXIT_FAILURE);
-            }
+            // Lê todos os datagramas disponíveis sem bloquear
+            while (true) {
+                addr_len = sizeof(client_addr);
+                ssize_t n = recvfrom(sockfd, buffer, BUFFER_SIZE, MSG_DONTWAIT,
+                                     (struct sockaddr *)&client_addr, &addr_len);
+
+                if (n < 0) {
+                    if (errno != EWOULDBLOCK && errno != EAGAIN && errno != EINTR) {
+                        perror("recvfrom failed");
+                    }
+                    break;
+                }
 
-            // Enviar ACK para START
-            ACKPacket ack_pkt;
-            ack_pkt.type = PKT_ACK;
-            ack_pkt.sequence_num = 0; // Não relevante para START
-            sendto(sockfd, &ack_pkt, sizeof(ACKPacket), 0, (const struct sockaddr *)&client_addr, addr_len);
-            verbose_log("[SERVER] Enviado ACK para START.\n");
-            
-            receiving_data = true;
-            expected_sequence = 0; // Inicia a sequência de dados
-            continue;
-        }
+                if (simulate_loss(loss_probability)) {
+                    verbose_log("[SERVER] >> Simulação de perda de pacote recebido.\n");
+                    continue;
+                }
 
-        if (!receiving_data) {
-            verbose_log("[SERVER] Aguardando pacote START. Pacote recebido descartado.\n");
-            continue;
-        }
-        
-        // Tratar pacotes de DADOS
-        if (header->type == PKT_DATA) {
-            Packet *data_pkt = (Packet *)buffer;
-            uint16_t calculated_chksum = calculate_checksum(data_pkt->payload, data_pkt->header.length);
-
-            if (calculated_chksum != data_pkt->header.checksum) {
-                verbose_log("[SERVER] Pacote de DADOS corrompido (seq: %d). Descartando.\n", data_pkt->header.sequence_num);
-                corrupted_packets++;
-                continue;
-            }
-            
-            total_packets_received++;
-            
-            if (data_pkt->header.sequence_num == expected_sequence) {
-                verbose_log("[SERVER] Recebido pacote de DADOS (seq: %d, len: %u).\n",
-                       data_pkt->header.sequence_num, data_pkt->header.length);
-
-                fwrite(data_pkt->payload, 1, data_pkt->header.length, output_file);
-                expected_sequence = 1 - expected_sequence;
-
-            } else {
-                verbose_log("[SERVER] Pacote duplicado (seq: %d). Esperava %d. Descartando.\n",
-                       data_pkt->header.sequence_num, expected_sequence);
-                duplicate_packets++;
-            }
+                PacketHeader *header = (PacketHeader *)buffer;
+                Session *session = find_session(&client_addr);
+
+                // Tratar pacotes START
+                if (header->type == PKT_START) {
+                    StartPacket *start_pkt = (StartPacket *)buffer;
+                    uint16_t calculated_chksum = calculate_checksum(start_pkt->filename, start_pkt->header.length);
+
+                    if (calculated_chksum != start_pkt->header.checksum) {
+                        verbose_log("[SERVER] Pacote START corrompido. Descartando.\n");
+                        corrupted_packets++;
+                        continue;
+                    }
+
+                    if (!session && !(session = open_session(&client_addr))) {
+                        verbose_log("[SERVER] Limite de %d sessões atingido. Pacote START descartado.\n", MAX_SESSIONS);
+                        continue;
+                    }
+
+                    char filename[MAX_FILENAME_SIZE + 1];
+                    strncpy(filename, start_pkt->filename, start_pkt->header.length);
+                    filename[start_pkt->header.length] = '\0';
+
+                    printf("Recebendo arquivo: %s\n", filename);
+
+                    if (session->output_file) fclose(session->output_file);
+                    session->output_file = fopen(filename, "wb");
+                    if (!session->output_file) {
+                        perror("Error opening output file");
+                        close_session(session);
+                        continue;
+                    }
+
+                    // Enviar ACK para START
+                    ACKPacket ack_pkt;
+                    ack_pkt.type = PKT_ACK;
+                    ack_pkt.sequence_num = 0; // Não relevante para START
+                    sendto(sockfd, &ack_pkt, sizeof(ACKPacket), 0, (const struct sockaddr *)&client_addr, addr_len);
+                    verbose_log("[SERVER] Enviado ACK para START.\n");
+
+                    session->expected_sequence = 0; // Inicia a sequência de dados
+                    touch_session(session);
+                    continue;
+                }
 
-            // Sempre envia ACK para o pacote que chegou, para o cliente não ficar em timeout
-            ACKPacket ack_pkt;
-            ack_pkt.type = PKT_ACK;
-            ack_pkt.sequence_num = data_pkt->header.sequence_num;
+                if (!session) {
+                    verbose_log("[SERVER] Aguardando pacote START. Pacote recebido descartado.\n");
+                    continue;
+                }
 
-            if (!simulate_loss(loss_probability)) {
-                sendto(sockfd, &ack_pkt, sizeof(ACKPacket), 0, (const struct sockaddr *)&client_addr, addr_len);
-                verbose_log("[SERVER] Enviado ACK para pacote (seq: %d).\n", ack_pkt.sequence_num);
-            } else {
-                verbose_log("[SERVER] >> Simulação de perda do ACK (para seq: %d).\n", ack_pkt.sequence_num);
+                // Tratar pacotes de DADOS
+                if (header->type == PKT_DATA) {
+                    Packet *data_pkt = (Packet *)buffer;
+                    uint16_t calculated_chksum = calculate_checksum(data_pkt->payload, data_pkt->header.length);
+
+                    if (calculated_chksum != data_pkt->header.checksum) {
+                        verbose_log("[SERVER] Pacote de DADOS corrompido (seq: %d). Descartando.\n", data_pkt->header.sequence_num);
+                        corrupted_packets++;
+                        continue;
+                    }
+
+                    total_packets_received++;
+                    touch_session(session);
+
+                    if (data_pkt->header.sequence_num == session->expected_sequence) {
+                        verbose_log("[SERVER] Recebido pacote de DADOS (seq: %d, len: %u).\n",
+                               data_pkt->header.sequence_num, data_pkt->header.length);
+
+                        fwrite(data_pkt->payload, 1, data_pkt->header.length, session->output_file);
+                        session->expected_sequence = 1 - session->expected_sequence;
+
+                    } else {
+                        verbose_log("[SERVER] Pacote duplicado (seq: %d). Esperava %d. Descartando.\n",
+                               data_pkt->header.sequence_num, session->expected_sequence);
+                        duplicate_packets++;
+                    }
+
+                    // Sempre confirma o pacote que chegou, para o cliente não ficar em timeout.
+                    // O ACK é atrasado: chegadas sucessivas antes do disparo geram um único ACK.
+                    session->pending_ack.type = PKT_ACK;
+                    session->pending_ack.sequence_num = data_pkt->header.sequence_num;
+                    if (!timer_pending(&session->ack_timer)) {
+                        timer_wheel_schedule(&wheel, &session->ack_timer, timer_wheel_now_ms() + ACK_DELAY_MS);
+                    }
+
+                } else if (header->type == PKT_EOT) {
+                    verbose_log("[SERVER] Recebido pacote de FIM DE TRANSMISSÃO.\n");
+
+                    // Enviar ACK para EOT
+                    ACKPacket ack_pkt;
+                    ack_pkt.type = PKT_ACK;
+                    ack_pkt.sequence_num = header->sequence_num;
+                    sendto(sockfd, &ack_pkt, sizeof(ACKPacket), 0, (const struct sockaddr *)&client_addr, addr_len);
+                    verbose_log("[SERVER] Enviado ACK para EOT (seq: %d).\n", ack_pkt.sequence_num);
+
+                    close_session(session);
+                    completed_transfers++;
+                }
             }
-
-        } else if (header->type == PKT_EOT) {
-            verbose_log("[SERVER] Recebido pacote de FIM DE TRANSMISSÃO.\n");
-            
-            // Enviar ACK para EOT
-            ACKPacket ack_pkt;
-            ack_pkt.type = PKT_ACK;
-            ack_pkt.sequence_num = header->sequence_num;
-            sendto(sockfd, &ack_pkt, sizeof(ACKPacket), 0, (const struct sockaddr *)&client_addr, addr_len);
-            verbose_log("[SERVER] Enviado ACK para EOT (seq: %d).\n", ack_pkt.sequence_num);
-
-            break; // Sair do loop
         }
+
+        timer_wheel_advance(&wheel, timer_wheel_now_ms());
     }
 
-    if(output_file) fclose(output_file);
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        if (sessions[i].in_use) close_session(&sessions[i]);
+    }
+    close(epoll_fd);
+    close(timer_fd);
     close(sockfd);
 
     printf("\n--- Estatísticas do Servidor ---\n");
@@ -212,8 +373,9 @@ int main(int argc, char *argv[]) {
     printf("Total de pacotes de dados recebidos: %lld\n", total_packets_received);
     printf("Pacotes duplicados descartados: %lld\n", duplicate_packets);
     printf("Pacotes corrompidos descartados: %lld\n", corrupted_packets);
+    printf("Sessões expiradas por inatividade: %lld\n", expired_sessions);
     printf("-----------------------------------\n");
 
 
     return 0;
-}
\ No newline at end of file
+}
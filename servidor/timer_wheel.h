@@ -0,0 +1,207 @@
+// timer_wheel.h
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+// Roda de temporização hierárquica (hierarchical timing wheel).
+// Cada tick equivale a 1 ms do relógio CLOCK_MONOTONIC. O nível L possui
+// TW_SLOTS posições de 64^L ticks cada; um timer é inserido no nível mais
+// baixo que comporta o seu prazo e desce de nível ("cascata") conforme o
+// tempo avança. Inserção e cancelamento são O(1). Timers cujo prazo já
+// passou vão para a lista 'due' e disparam na próxima chamada de
+// timer_wheel_advance, sem esperar o próximo tick.
+
+#define TW_BITS      6
+#define TW_SLOTS     (1 << TW_BITS)
+#define TW_MASK      (TW_SLOTS - 1)
+#define TW_LEVELS    4
+#define TW_MAX_DELAY (((uint64_t)1 << (TW_BITS * TW_LEVELS)) - 1) // ~4,6 horas
+#define TW_NEVER     UINT64_MAX
+
+typedef struct Timer Timer;
+typedef void (*TimerCallback)(Timer *timer, void *arg);
+
+// Timer intrusivo: fica embutido na estrutura que o utiliza (sessão, transferência)
+struct Timer {
+    Timer        *next;
+    Timer       **pprev;   // NULL quando o timer não está agendado
+    uint64_t      expires; // Prazo absoluto em ms
+    TimerCallback callback;
+    void         *arg;
+};
+
+typedef struct {
+    Timer   *slots[TW_LEVELS][TW_SLOTS];
+    Timer   *due;     // Timers com prazo anterior a current
+    uint64_t current; // Próximo tick ainda não processado
+    uint64_t armed;   // Prazo atualmente programado no timerfd
+    size_t   count;   // Número de timers agendados
+} TimerWheel;
+
+static inline uint64_t timer_wheel_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static inline void timer_init(Timer *timer, TimerCallback callback, void *arg) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+static inline bool timer_pending(const Timer *timer) {
+    return timer->pprev != NULL;
+}
+
+static inline void timer_wheel_init(TimerWheel *tw, uint64_t now) {
+    memset(tw->slots, 0, sizeof(tw->slots));
+    tw->due = NULL;
+    tw->current = now;
+    tw->armed = TW_NEVER;
+    tw->count = 0;
+}
+
+// Coloca o timer na posição correspondente ao seu prazo, relativo a tw->current
+static inline void timer_wheel_link(TimerWheel *tw, Timer *timer) {
+    Timer **head;
+
+    if (timer->expires < tw->current) {
+        head = &tw->due;
+    } else {
+        uint64_t delta = timer->expires - tw->current;
+        if (delta > TW_MAX_DELAY) {
+            delta = TW_MAX_DELAY;
+            timer->expires = tw->current + TW_MAX_DELAY;
+        }
+
+        int level = 0;
+        while (delta >= ((uint64_t)1 << (TW_BITS * (level + 1)))) {
+            level++;
+        }
+        head = &tw->slots[level][(timer->expires >> (TW_BITS * level)) & TW_MASK];
+    }
+
+    timer->next = *head;
+    if (*head) (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+}
+
+static inline void timer_cancel(TimerWheel *tw, Timer *timer) {
+    if (!timer_pending(timer)) return;
+    *timer->pprev = timer->next;
+    if (timer->next) timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+    tw->count--;
+}
+
+// Agenda (ou reagenda) o timer para o instante absoluto 'expires', em ms
+static inline void timer_wheel_schedule(TimerWheel *tw, Timer *timer, uint64_t expires) {
+    timer_cancel(tw, timer);
+    timer->expires = expires;
+    timer_wheel_link(tw, timer);
+    tw->count++;
+}
+
+// Redistribui os timers de uma posição de nível superior nos níveis inferiores
+static inline void timer_wheel_cascade(TimerWheel *tw, int level, uint64_t tick) {
+    Timer **slot = &tw->slots[level][(tick >> (TW_BITS * level)) & TW_MASK];
+    Timer *timer = *slot;
+    *slot = NULL;
+    while (timer) {
+        Timer *next = timer->next;
+        timer_wheel_link(tw, timer);
+        timer = next;
+    }
+}
+
+// Dispara a lista de timers desanexada; os callbacks podem cancelar ou
+// reagendar timers (inclusive o próprio), já que cada um é removido antes.
+static inline void timer_wheel_fire(TimerWheel *tw, Timer *expired) {
+    if (expired) expired->pprev = &expired;
+    while (expired) {
+        Timer *timer = expired;
+        timer_cancel(tw, timer);
+        timer->callback(timer, timer->arg);
+    }
+}
+
+// Dispara os timers vencidos e, em ordem, todos com prazo até 'now' (inclusive)
+static inline void timer_wheel_advance(TimerWheel *tw, uint64_t now) {
+    Timer *due = tw->due;
+    tw->due = NULL;
+    timer_wheel_fire(tw, due);
+
+    if (tw->count == 0) {
+        if (tw->current <= now) tw->current = now + 1;
+        return;
+    }
+
+    while (tw->current <= now) {
+        uint64_t tick = tw->current;
+
+        for (int level = 1; level < TW_LEVELS; level++) {
+            if ((tick >> (TW_BITS * (level - 1))) & TW_MASK) break;
+            timer_wheel_cascade(tw, level, tick);
+        }
+
+        Timer *expired = tw->slots[0][tick & TW_MASK];
+        tw->slots[0][tick & TW_MASK] = NULL;
+        tw->current = tick + 1;
+        timer_wheel_fire(tw, expired);
+    }
+}
+
+// Próximo instante em que a roda precisa ser avançada, ou TW_NEVER.
+// Para níveis superiores retorna o instante da cascata, que nunca é
+// posterior ao prazo real dos timers daquela posição.
+static inline uint64_t timer_wheel_next_expiry(const TimerWheel *tw) {
+    uint64_t next = TW_NEVER;
+    if (tw->count == 0) return next;
+    if (tw->due) return tw->current - 1; // Já vencido: o timerfd dispara imediatamente
+
+    for (int level = 0; level < TW_LEVELS; level++) {
+        int shift = TW_BITS * level;
+        uint64_t first = (tw->current + ((uint64_t)1 << shift) - 1) >> shift;
+        for (uint64_t i = 0; i < TW_SLOTS; i++) {
+            uint64_t position = first + i;
+            if (tw->slots[level][position & TW_MASK]) {
+                uint64_t when = position << shift;
+                if (when < next) next = when;
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+// Programa o timerfd (CLOCK_MONOTONIC) para o próximo prazo da roda.
+// Só chama timerfd_settime quando o prazo muda ou há timers vencidos.
+static inline int timer_wheel_arm_timerfd(TimerWheel *tw, int timer_fd) {
+    uint64_t deadline = timer_wheel_next_expiry(tw);
+    if (deadline == tw->armed && !tw->due) return 0;
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (deadline != TW_NEVER) {
+        its.it_value.tv_sec = deadline / 1000;
+        its.it_value.tv_nsec = (deadline % 1000) * 1000000;
+    }
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        return -1;
+    }
+    tw->armed = deadline;
+    return 0;
+}
+
+#endif // TIMER_WHEEL_H